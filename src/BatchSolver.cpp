@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <cstring>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "BatchSolver.h"
+
+//Operations over the 16 lanes of a group. With AVX2 each of them is one instruction.
+//Without it they are plain loops, which the compiler can still vectorize with narrower instructions
+#ifdef __AVX2__
+typedef __m256i Lanes;
+
+static inline Lanes loadLanes(const uint16_t* lanes) {
+	return _mm256_load_si256((const __m256i*)lanes);
+}
+
+static inline void storeLanes(uint16_t* lanes, Lanes value) {
+	_mm256_store_si256((__m256i*)lanes, value);
+}
+
+static inline Lanes setLanes(uint16_t value) {
+	return _mm256_set1_epi16(value);
+}
+
+static inline Lanes andLanes(Lanes first, Lanes second) {
+	return _mm256_and_si256(first, second);
+}
+
+static inline Lanes orLanes(Lanes first, Lanes second) {
+	return _mm256_or_si256(first, second);
+}
+
+static inline Lanes xorLanes(Lanes first, Lanes second) {
+	return _mm256_xor_si256(first, second);
+}
+
+//first & ~second
+static inline Lanes andNotLanes(Lanes first, Lanes second) {
+	return _mm256_andnot_si256(second, first);
+}
+
+static inline Lanes subtractLanes(Lanes first, Lanes second) {
+	return _mm256_sub_epi16(first, second);
+}
+
+//All bits set on the lanes where both are equal
+static inline Lanes equalLanes(Lanes first, Lanes second) {
+	return _mm256_cmpeq_epi16(first, second);
+}
+
+static inline bool anyLane(Lanes value) {
+	return !_mm256_testz_si256(value, value);
+}
+#else
+struct Lanes {
+	uint16_t lane[BatchSolver::lanes];
+};
+
+static inline Lanes loadLanes(const uint16_t* lanes) {
+	Lanes output;
+	std::memcpy(output.lane, lanes, sizeof(output.lane));
+	return output;
+}
+
+static inline void storeLanes(uint16_t* lanes, Lanes value) {
+	std::memcpy(lanes, value.lane, sizeof(value.lane));
+}
+
+static inline Lanes setLanes(uint16_t value) {
+	Lanes output;
+	for (int i = 0; i < BatchSolver::lanes; i++) {
+		output.lane[i] = value;
+	}
+	return output;
+}
+
+static inline Lanes andLanes(Lanes first, Lanes second) {
+	for (int i = 0; i < BatchSolver::lanes; i++) {
+		first.lane[i] &= second.lane[i];
+	}
+	return first;
+}
+
+static inline Lanes orLanes(Lanes first, Lanes second) {
+	for (int i = 0; i < BatchSolver::lanes; i++) {
+		first.lane[i] |= second.lane[i];
+	}
+	return first;
+}
+
+static inline Lanes xorLanes(Lanes first, Lanes second) {
+	for (int i = 0; i < BatchSolver::lanes; i++) {
+		first.lane[i] ^= second.lane[i];
+	}
+	return first;
+}
+
+//first & ~second
+static inline Lanes andNotLanes(Lanes first, Lanes second) {
+	for (int i = 0; i < BatchSolver::lanes; i++) {
+		first.lane[i] &= ~second.lane[i];
+	}
+	return first;
+}
+
+static inline Lanes subtractLanes(Lanes first, Lanes second) {
+	for (int i = 0; i < BatchSolver::lanes; i++) {
+		first.lane[i] -= second.lane[i];
+	}
+	return first;
+}
+
+//All bits set on the lanes where both are equal
+static inline Lanes equalLanes(Lanes first, Lanes second) {
+	for (int i = 0; i < BatchSolver::lanes; i++) {
+		first.lane[i] = first.lane[i] == second.lane[i] ? 0xFFFF : 0;
+	}
+	return first;
+}
+
+static inline bool anyLane(Lanes value) {
+	for (int i = 0; i < BatchSolver::lanes; i++) {
+		if (value.lane[i] != 0) {
+			return true;
+		}
+	}
+	return false;
+}
+#endif
+
+const int BatchSolver::lanes;
+
+BatchSolver::BatchSolver(SolveLimits limits, std::chrono::milliseconds timeout) : tables(BitboardSolver::getTables()) {
+	this->limits = limits;
+	this->timeout = timeout;
+}
+
+void BatchSolver::propagateGroup(uint16_t* group) {
+	const Lanes zero = setLanes(0);
+	const Lanes one = setLanes(1);
+
+	//Every step only removes possible numbers, so this always ends
+	bool changed = true;
+	while (changed) {
+		Lanes changedLanes = zero;
+
+		//We get the number of the solved cells of every sudoku. A mask is solved if mask & (mask - 1) is 0
+		Lanes solvedNumbers[81];
+		for (int cell = 0; cell < 81; cell++) {
+			Lanes mask = loadLanes(group + cell * lanes);
+			Lanes solved = equalLanes(andLanes(mask, subtractLanes(mask, one)), zero);
+			solvedNumbers[cell] = andLanes(mask, solved);
+		}
+
+		//We remove them from their peers. If two peers have the same number, both become 0 and the sudoku has no solution
+		for (int cell = 0; cell < 81; cell++) {
+			Lanes taken = zero;
+			for (int peer : this->tables.peers[cell]) {
+				taken = orLanes(taken, solvedNumbers[peer]);
+			}
+			Lanes mask = loadLanes(group + cell * lanes);
+			Lanes newMask = andNotLanes(mask, taken);
+			changedLanes = orLanes(changedLanes, xorLanes(mask, newMask));
+			storeLanes(group + cell * lanes, newMask);
+		}
+
+		//We look for the numbers only possible in one cell of a unit
+		for (int unit = 0; unit < 27; unit++) {
+			Lanes atLeastOnce = zero;
+			Lanes moreThanOnce = zero;
+			for (int cell : this->tables.units[unit]) {
+				Lanes mask = loadLanes(group + cell * lanes);
+				moreThanOnce = orLanes(moreThanOnce, andLanes(atLeastOnce, mask));
+				atLeastOnce = orLanes(atLeastOnce, mask);
+			}
+			Lanes onlyOnce = andNotLanes(atLeastOnce, moreThanOnce);
+
+			//The cells with a hidden single keep only that number. If a cell gets two of them,
+			//the sudoku has no solution and BitboardSolver will find it out
+			for (int cell : this->tables.units[unit]) {
+				Lanes mask = loadLanes(group + cell * lanes);
+				Lanes hiddenSingle = andLanes(mask, onlyOnce);
+				Lanes noHiddenSingle = equalLanes(hiddenSingle, zero);
+				Lanes newMask = orLanes(hiddenSingle, andLanes(noHiddenSingle, mask));
+				changedLanes = orLanes(changedLanes, xorLanes(mask, newMask));
+				storeLanes(group + cell * lanes, newMask);
+			}
+		}
+
+		changed = anyLane(changedLanes);
+	}
+}
+
+std::vector<SolveStatus> BatchSolver::solve(std::vector<uint16_t>& sudokus) {
+	int amount = sudokus.size() / 81;
+	std::vector<SolveStatus> output(amount, SolveStatus::Unsolvable);
+
+	//The group is stored cell by cell: the 16 masks of cell 0, then the ones of cell 1...
+	alignas(32) uint16_t group[81 * lanes];
+	for (int first = 0; first < amount; first += lanes) {
+		int inGroup = std::min(lanes, amount - first);
+
+		//The lanes without a sudoku are left vacant, propagating them doesn't do anything
+		for (int cell = 0; cell < 81; cell++) {
+			for (int lane = 0; lane < lanes; lane++) {
+				group[cell * lanes + lane] = lane < inGroup ? sudokus.at((first + lane) * 81 + cell) : BitboardSolver::allNumbers;
+			}
+		}
+
+		this->propagateGroup(group);
+
+		for (int lane = 0; lane < inGroup; lane++) {
+			uint16_t* cells = sudokus.data() + (first + lane) * 81;
+			bool empty = false;
+			bool solved = true;
+			for (int cell = 0; cell < 81; cell++) {
+				uint16_t mask = group[cell * lanes + lane];
+				cells[cell] = mask;
+				if (mask == 0) {
+					empty = true;
+				}
+				else if ((mask & (mask - 1)) != 0) {
+					solved = false;
+				}
+			}
+
+			//Propagation only makes forced deductions, so a sudoku solved by it has only one solution
+			if (empty) {
+				output.at(first + lane) = SolveStatus::Unsolvable;
+			}
+			else if (solved) {
+				output.at(first + lane) = SolveStatus::Solved;
+			}
+			else {
+				//Each sudoku gets its own time, counted from the moment we start searching it
+				SolveLimits sudokuLimits = this->limits;
+				if (this->timeout.count() > 0) {
+					sudokuLimits.deadline = std::min(this->limits.deadline, std::chrono::steady_clock::now() + this->timeout);
+				}
+				output.at(first + lane) = this->bitboardSolver.solve(cells, sudokuLimits).status;
+			}
+		}
+	}
+	return output;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "BitboardSolver.h"
+
+//Solves many 9x9 sudokus at once. The masks of 16 sudokus are interleaved, one per 16-bit lane,
+//so each AVX2 instruction propagates all of them at the same time. The sudokus that can't be solved
+//by propagation alone are finished one by one with BitboardSolver
+class BatchSolver {
+public:
+	//Amount of sudokus propagated together
+	static const int lanes = 16;
+private:
+	//Units and peers, shared with BitboardSolver
+	const StandardTables& tables;
+
+	//Search engine for the sudokus that need guessing
+	BitboardSolver bitboardSolver;
+	SolveLimits limits;
+	//Time each sudoku has to be solved. 0 means no limit
+	std::chrono::milliseconds timeout;
+
+	//Propagates a group of sudokus until none of them changes. The group is cell by cell, with one lane per sudoku
+	void propagateGroup(uint16_t* group);
+public:
+	//The deadline of the limits applies to the whole batch, and the timeout to each sudoku
+	BatchSolver(SolveLimits limits, std::chrono::milliseconds timeout);
+	//Solves the sudokus in place. Each of them is 81 consecutive masks, as in BitboardSolver
+	std::vector<SolveStatus> solve(std::vector<uint16_t>& sudokus);
+};
\ No newline at end of file
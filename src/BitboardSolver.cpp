@@ -0,0 +1,197 @@
+#include <cstring>
+
+#include "BitboardSolver.h"
+#include "Layout.h"
+
+const uint16_t BitboardSolver::allNumbers;
+
+StandardTables::StandardTables() {
+	Layout layout(3);
+	for (int unit = 0; unit < 27; unit++) {
+		for (int i = 0; i < 9; i++) {
+			this->units[unit][i] = layout.getUnits().at(unit).at(i);
+		}
+	}
+	for (int cell = 0; cell < 81; cell++) {
+		for (int i = 0; i < 20; i++) {
+			this->peers[cell][i] = layout.getPeers(cell).at(i);
+		}
+	}
+}
+
+BitboardSolver::BitboardSolver() : tables(getTables()) {
+	this->nodes = 0;
+}
+
+const StandardTables& BitboardSolver::getTables() {
+	static const StandardTables tables;
+	return tables;
+}
+
+bool BitboardSolver::parse(std::string line, uint16_t* cells) {
+	//As in the .sdkstring files, only the first 81 characters are read. The rest of the line (a carriage return, a comment...) is ignored
+	if (line.size() < 81) {
+		return false;
+	}
+
+	for (int cell = 0; cell < 81; cell++) {
+		char aux = line.at(cell);
+		if (aux == '0' || aux == '.') {
+			cells[cell] = allNumbers;
+		}
+		else if (aux >= '1' && aux <= '9') {
+			cells[cell] = 1 << (aux - '1');
+		}
+		else {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string BitboardSolver::toString(const uint16_t* cells) {
+	std::string output;
+	for (int cell = 0; cell < 81; cell++) {
+		//Only the cells with a single number are written
+		if (cells[cell] != 0 && (cells[cell] & (cells[cell] - 1)) == 0) {
+			output += (char)('1' + __builtin_ctz(cells[cell]));
+		}
+		else {
+			output += '.';
+		}
+	}
+	return output;
+}
+
+bool BitboardSolver::propagate(uint16_t* cells) {
+	bool changed = true;
+	while (changed) {
+		changed = false;
+
+		//We remove the numbers of the solved cells from their peers
+		for (int cell = 0; cell < 81; cell++) {
+			uint16_t mask = cells[cell];
+			if (mask == 0) {
+				return false;
+			}
+			if ((mask & (mask - 1)) == 0) {
+				for (int peer : this->tables.peers[cell]) {
+					if (cells[peer] & mask) {
+						if (cells[peer] == mask) {
+							return false;
+						}
+						cells[peer] &= ~mask;
+						changed = true;
+					}
+				}
+			}
+		}
+
+		//We look for the numbers only possible in one cell of a unit
+		for (int unit = 0; unit < 27; unit++) {
+			uint16_t atLeastOnce = 0;
+			uint16_t moreThanOnce = 0;
+			for (int cell : this->tables.units[unit]) {
+				moreThanOnce |= atLeastOnce & cells[cell];
+				atLeastOnce |= cells[cell];
+			}
+			if (atLeastOnce != allNumbers) {
+				return false;
+			}
+
+			uint16_t onlyOnce = atLeastOnce & ~moreThanOnce;
+			if (onlyOnce != 0) {
+				for (int cell : this->tables.units[unit]) {
+					uint16_t hiddenSingle = cells[cell] & onlyOnce;
+					if (hiddenSingle != 0 && hiddenSingle != cells[cell]) {
+						//Two numbers that can only go in the same cell
+						if ((hiddenSingle & (hiddenSingle - 1)) != 0) {
+							return false;
+						}
+						cells[cell] = hiddenSingle;
+						changed = true;
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+SolveResult BitboardSolver::solve(uint16_t* cells, SolveLimits limits) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	this->limits = limits;
+	this->nodes = 0;
+	this->solution.clear();
+
+	SolveResult result;
+	result.status = this->search(cells);
+	result.nodes = this->nodes;
+
+	if (!this->solution.empty()) {
+		std::memcpy(cells, this->solution.data(), 81 * sizeof(uint16_t));
+	}
+
+	result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	return result;
+}
+
+SolveStatus BitboardSolver::search(uint16_t* cells) {
+	//Nodes here are much cheaper than on Sudoku::solve, so the clock is only read every 1024 of them
+	this->nodes++;
+	if (this->limits.maxNodes != 0 && this->nodes > this->limits.maxNodes) {
+		return SolveStatus::BudgetExceeded;
+	}
+	if ((this->nodes & 1023) == 0 && std::chrono::steady_clock::now() > this->limits.deadline) {
+		return SolveStatus::BudgetExceeded;
+	}
+
+	if (!this->propagate(cells)) {
+		return SolveStatus::Unsolvable;
+	}
+
+	//We look for the vacant cell with the fewest possible numbers
+	int guessedCell = -1;
+	int fewestNumbers = 10;
+	for (int cell = 0; cell < 81; cell++) {
+		int amount = __builtin_popcount(cells[cell]);
+		if (amount > 1 && amount < fewestNumbers) {
+			guessedCell = cell;
+			fewestNumbers = amount;
+		}
+	}
+
+	//If every cell has a single number, it's solved. If we already had a solution, the sudoku has more than one
+	if (guessedCell == -1) {
+		if (!this->solution.empty()) {
+			return SolveStatus::MultipleSolutions;
+		}
+		this->solution.assign(cells, cells + 81);
+		return SolveStatus::Solved;
+	}
+
+	bool found = false;
+	uint16_t possibleNumbers = cells[guessedCell];
+	while (possibleNumbers != 0) {
+		uint16_t number = possibleNumbers & -possibleNumbers;
+		possibleNumbers &= ~number;
+
+		uint16_t guess[81];
+		std::memcpy(guess, cells, sizeof(guess));
+		guess[guessedCell] = number;
+
+		SolveStatus status = this->search(guess);
+		if (status == SolveStatus::Solved) {
+			found = true;
+			//If we don't have to check that it's the only solution, we can stop here
+			if (!this->limits.checkUniqueness) {
+				return SolveStatus::Solved;
+			}
+		}
+		else if (status != SolveStatus::Unsolvable) {
+			return status;
+		}
+	}
+	return found ? SolveStatus::Solved : SolveStatus::Unsolvable;
+}
\ No newline at end of file
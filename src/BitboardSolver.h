@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Sudoku.h"
+
+//Units and peers of the standard 9x9 sudoku, copied from Layout to small tables
+struct StandardTables {
+	//Rows, columns and sub-squares
+	uint8_t units[27][9];
+	//The 20 peers of every cell
+	uint8_t peers[81][20];
+
+	StandardTables();
+};
+
+//Fast solver for standard 9x9 sudokus. Each cell is a mask of its possible numbers, where bit 0 is the number 1,
+//so a cell with a single bit is solved. Used as the search engine when propagation alone isn't enough
+class BitboardSolver {
+private:
+	//Units and peers, shared by every solver
+	const StandardTables& tables;
+
+	SolveLimits limits;
+	long nodes;
+	//First solution found
+	std::vector<uint16_t> solution;
+
+	//Guesses on the cell with the fewest possible numbers
+	SolveStatus search(uint16_t* cells);
+public:
+	//Mask with every number possible
+	static const uint16_t allNumbers = 0x1FF;
+
+	BitboardSolver();
+	//Gives the tables, which are built only once and shared by every solver
+	static const StandardTables& getTables();
+	//Reads a sudoku in the .sdkstring format, with 0 or . as vacant cells. Anything after the first 81 characters is ignored.
+	//Returns false if it isn't valid
+	static bool parse(std::string line, uint16_t* cells);
+	//Writes the sudoku in the .sdkstring format
+	static std::string toString(const uint16_t* cells);
+	//Removes the numbers of the solved cells from their peers and fills the hidden singles until nothing changes.
+	//Returns false if the sudoku has no solution
+	bool propagate(uint16_t* cells);
+	//Solves the 81 cells in place
+	SolveResult solve(uint16_t* cells, SolveLimits limits);
+};
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "Layout.h"
+
+Layout::Layout(int size) {
+	this->size = size;
+	this->sideLength = size * size;
+	this->nonConsecutive = false;
+	this->rectangularRegions = true;
+
+	//By default the regions are the rectangular sub-squares
+	for (int y = 0; y < this->sideLength; y++) {
+		for (int x = 0; x < this->sideLength; x++) {
+			this->regionOfCell.push_back((x / size) + (y / size) * size);
+		}
+	}
+
+	this->compile();
+}
+
+void Layout::setRegions(std::vector<int> regionOfCell) {
+	if (regionOfCell.size() != this->sideLength * this->sideLength) {
+		throw std::runtime_error("Regions don't cover the whole sudoku");
+	}
+
+	//Every region has to have exactly one cell for every number
+	std::vector<int> cellsInRegion(this->sideLength, 0);
+	for (int region : regionOfCell) {
+		if (region < 0 || region >= this->sideLength) {
+			throw std::runtime_error("Invalid region " + std::to_string(region));
+		}
+		cellsInRegion.at(region)++;
+	}
+	for (int amount : cellsInRegion) {
+		if (amount != this->sideLength) {
+			throw std::runtime_error("Every region must have " + std::to_string(this->sideLength) + " cells");
+		}
+	}
+
+	//The regions are still the sub-squares if all the cells of each sub-square share their region
+	this->rectangularRegions = true;
+	for (int cell = 0; cell < regionOfCell.size(); cell++) {
+		int x = cell % this->sideLength;
+		int y = cell / this->sideLength;
+		int topLeftOfSubSquare = (x - x % this->size) + this->sideLength * (y - y % this->size);
+		if (regionOfCell.at(cell) != regionOfCell.at(topLeftOfSubSquare)) {
+			this->rectangularRegions = false;
+		}
+	}
+
+	this->regionOfCell = regionOfCell;
+}
+
+void Layout::addDiagonals() {
+	std::vector<int> mainDiagonal;
+	std::vector<int> antiDiagonal;
+	for (int i = 0; i < this->sideLength; i++) {
+		mainDiagonal.push_back(i + this->sideLength * i);
+		antiDiagonal.push_back((this->sideLength - 1 - i) + this->sideLength * i);
+	}
+	this->extraUnits.push_back(mainDiagonal);
+	this->extraUnits.push_back(antiDiagonal);
+}
+
+void Layout::addCage(int sum, std::vector<int> cells) {
+	//The biggest sum a cage can have is the one of all the numbers
+	if (sum < 1 || sum > this->sideLength * (this->sideLength + 1) / 2) {
+		throw std::runtime_error("Invalid cage sum " + std::to_string(sum));
+	}
+	for (int cell : cells) {
+		if (cell < 0 || cell >= this->sideLength * this->sideLength) {
+			throw std::runtime_error("Cage cell outside of the sudoku");
+		}
+	}
+
+	Cage cage;
+	cage.sum = sum;
+	cage.cells = cells;
+	this->cages.push_back(cage);
+}
+
+void Layout::setNonConsecutive() {
+	this->nonConsecutive = true;
+}
+
+void Layout::compile() {
+	int amountOfCells = this->sideLength * this->sideLength;
+
+	//We build the units. First the rows and the columns
+	this->units.clear();
+	for (int y = 0; y < this->sideLength; y++) {
+		std::vector<int> row;
+		for (int x = 0; x < this->sideLength; x++) {
+			row.push_back(x + this->sideLength * y);
+		}
+		this->units.push_back(row);
+	}
+	for (int x = 0; x < this->sideLength; x++) {
+		std::vector<int> column;
+		for (int y = 0; y < this->sideLength; y++) {
+			column.push_back(x + this->sideLength * y);
+		}
+		this->units.push_back(column);
+	}
+
+	//Now the regions
+	std::vector<std::vector<int>> regions(this->sideLength);
+	for (int cell = 0; cell < amountOfCells; cell++) {
+		regions.at(this->regionOfCell.at(cell)).push_back(cell);
+	}
+	for (std::vector<int>& region : regions) {
+		this->units.push_back(region);
+	}
+
+	for (std::vector<int>& extraUnit : this->extraUnits) {
+		this->units.push_back(extraUnit);
+	}
+
+	//We build the peers. Two cells are peers if they share a unit or a cage
+	std::vector<std::vector<bool>> isPeer(amountOfCells, std::vector<bool>(amountOfCells, false));
+	for (std::vector<int>& unit : this->units) {
+		for (int first : unit) {
+			for (int second : unit) {
+				isPeer.at(first).at(second) = true;
+			}
+		}
+	}
+	for (Cage& cage : this->cages) {
+		for (int first : cage.cells) {
+			for (int second : cage.cells) {
+				isPeer.at(first).at(second) = true;
+			}
+		}
+	}
+
+	this->peers.assign(amountOfCells, std::vector<int>());
+	for (int cell = 0; cell < amountOfCells; cell++) {
+		for (int other = 0; other < amountOfCells; other++) {
+			if (other != cell && isPeer.at(cell).at(other)) {
+				this->peers.at(cell).push_back(other);
+			}
+		}
+	}
+
+	//We build the neighbours for the non-consecutive constraint
+	this->neighbours.assign(amountOfCells, std::vector<int>());
+	if (this->nonConsecutive) {
+		for (int cell = 0; cell < amountOfCells; cell++) {
+			int x = cell % this->sideLength;
+			int y = cell / this->sideLength;
+			if (x > 0) {
+				this->neighbours.at(cell).push_back(cell - 1);
+			}
+			if (x < this->sideLength - 1) {
+				this->neighbours.at(cell).push_back(cell + 1);
+			}
+			if (y > 0) {
+				this->neighbours.at(cell).push_back(cell - this->sideLength);
+			}
+			if (y < this->sideLength - 1) {
+				this->neighbours.at(cell).push_back(cell + this->sideLength);
+			}
+		}
+	}
+
+	//We build the intersections. Units sharing only one cell are skipped, as that case is already a hidden single
+	this->intersections.clear();
+	std::vector<int> unitOfCellMark(amountOfCells, -1);
+	for (int first = 0; first < this->units.size(); first++) {
+		for (int cell : this->units.at(first)) {
+			unitOfCellMark.at(cell) = first;
+		}
+		for (int second = first + 1; second < this->units.size(); second++) {
+			UnitIntersection intersection;
+			intersection.firstUnit = first;
+			intersection.secondUnit = second;
+			for (int cell : this->units.at(second)) {
+				if (unitOfCellMark.at(cell) == first) {
+					intersection.sharedCells.push_back(cell);
+				}
+			}
+			//If they share every cell, it's the same unit
+			if (intersection.sharedCells.size() > 1 && intersection.sharedCells.size() < this->sideLength) {
+				for (int cell : this->units.at(first)) {
+					intersection.sharedInFirst.push_back(std::find(intersection.sharedCells.begin(), intersection.sharedCells.end(), cell) != intersection.sharedCells.end());
+				}
+				for (int cell : this->units.at(second)) {
+					intersection.sharedInSecond.push_back(unitOfCellMark.at(cell) == first);
+				}
+				this->intersections.push_back(intersection);
+			}
+		}
+	}
+}
+
+int Layout::getSize() {
+	return this->size;
+}
+
+int Layout::getSideLength() {
+	return this->sideLength;
+}
+
+int Layout::getRegionOfCell(int cell) {
+	return this->regionOfCell.at(cell);
+}
+
+std::vector<std::vector<int>>& Layout::getUnits() {
+	return this->units;
+}
+
+std::vector<int>& Layout::getPeers(int cell) {
+	return this->peers.at(cell);
+}
+
+std::vector<int>& Layout::getNeighbours(int cell) {
+	return this->neighbours.at(cell);
+}
+
+std::vector<UnitIntersection>& Layout::getIntersections() {
+	return this->intersections;
+}
+
+std::vector<Cage>& Layout::getCages() {
+	return this->cages;
+}
+
+bool Layout::isNonConsecutive() {
+	return this->nonConsecutive;
+}
+
+bool Layout::hasRectangularRegions() {
+	return this->rectangularRegions;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+
+//Killer cage. The cells inside can't repeat numbers and must add up to sum
+struct Cage {
+	int sum;
+	std::vector<int> cells;
+};
+
+//Two units sharing more than one cell. If a number of one of them is only possible
+//inside the shared cells, it can be removed from the rest of the other one
+struct UnitIntersection {
+	int firstUnit;
+	int secondUnit;
+	std::vector<int> sharedCells;
+	//Indicates for every position of each unit if that cell is shared, so the solver doesn't have to search sharedCells
+	std::vector<bool> sharedInFirst;
+	std::vector<bool> sharedInSecond;
+};
+
+//Describes the constraints of a sudoku. Cells are referred by their index: positionX + sideLength * positionY
+class Layout {
+private:
+	//Number of columns in one standard subsquare
+	int size;
+	//Number of cells in one row
+	int sideLength;
+
+	//Region of each cell. By default the rectangular sub-squares
+	std::vector<int> regionOfCell;
+	//Extra units that are not rows, columns or regions (diagonals)
+	std::vector<std::vector<int>> extraUnits;
+	//Killer cages
+	std::vector<Cage> cages;
+	//Orthogonally adjacent cells can't hold consecutive numbers
+	bool nonConsecutive;
+	//False if the regions aren't the standard sub-squares
+	bool rectangularRegions;
+
+	//Tables built by compile()
+	//Every unit must contain every number once. Order: rows, columns, regions and extra units
+	std::vector<std::vector<int>> units;
+	//Cells that can't share a number with each cell
+	std::vector<std::vector<int>> peers;
+	//Orthogonally adjacent cells of each cell. Only filled for non-consecutive sudokus
+	std::vector<std::vector<int>> neighbours;
+	std::vector<UnitIntersection> intersections;
+public:
+	//Standard sudoku with rectangular sub-squares
+	Layout(int size);
+	//Replaces the sub-squares with irregular regions (jigsaw). Every region must have sideLength cells
+	void setRegions(std::vector<int> regionOfCell);
+	//Adds both diagonals as units (X-Sudoku)
+	void addDiagonals();
+	//Adds a killer cage. Throws std::runtime_error if the sum or a cell is out of range
+	void addCage(int sum, std::vector<int> cells);
+	//Forbids consecutive numbers on orthogonally adjacent cells
+	void setNonConsecutive();
+	//Builds the units, peers and intersections. Has to be called after the last change
+	void compile();
+
+	int getSize();
+	int getSideLength();
+	int getRegionOfCell(int cell);
+	std::vector<std::vector<int>>& getUnits();
+	std::vector<int>& getPeers(int cell);
+	std::vector<int>& getNeighbours(int cell);
+	std::vector<UnitIntersection>& getIntersections();
+	std::vector<Cage>& getCages();
+	bool isNonConsecutive();
+	bool hasRectangularRegions();
+};
\ No newline at end of file
@@ -1,8 +1,14 @@
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 
 #include "Cell.h"
+#include "Layout.h"
 #include "Sudoku.h"
 
 //Function to split a 
@@ -30,33 +36,66 @@ std::vector<std::string> Sudoku::splitString(std::string line, std::string separ
 }
 
 
-Sudoku::Sudoku(std::vector<Cell*> cells, int size) {
+Sudoku::Sudoku(std::vector<Cell*> cells, int size) : Sudoku(cells, size, std::make_shared<Layout>(size)) {
+}
+
+Sudoku::Sudoku(std::vector<Cell*> cells, int size, std::shared_ptr<Layout> layout) {
 	this->size = size;
+	this->layout = layout;
 	for (Cell* cell : cells) {
 		this->cells.push_back(new Cell(cell->getValue(), cell->getPositionX(), cell->getPositionY(), cell->getPossibleValues()));
 	}
 }
 
+Sudoku::~Sudoku() {
+	for (Cell* cell : this->cells) {
+		delete(cell);
+	}
+}
+
 Sudoku::Sudoku(std::string fileName) {
+	try {
+		this->readFile(fileName);
+	}
+	catch (...) {
+		//The destructor isn't called if the constructor fails, so we free the cells read until now
+		for (Cell* cell : this->cells) {
+			delete(cell);
+		}
+		throw;
+	}
+}
+
+void Sudoku::readFile(std::string fileName) {
 	//We detect the filetype
 	std::vector<std::string> fileNameParts = this->splitString(fileName, ".");
 
 	//We open the file
 	std::ifstream file;
 	file.open(fileName);
+	if (!file.is_open()) {
+		throw std::runtime_error("Can't open " + fileName);
+	}
 
 	//Holds the lines from the file
 	std::string line;
 
+	//Only our own format can have constraints after the grid
+	bool hasConstraints = false;
+
 	if (fileNameParts.size() == 0 || fileNameParts.at(fileNameParts.size() - 1).compare("sudoku") == 0) {
 		//Personal type
+		hasConstraints = true;
 
 		//We start reading the file. First line contains the size of the sudoku. 
 		//It represents the amount of columns in one sub-square
 		std::getline(file, line);
 		this->size = std::atoi(line.c_str());
+		if (this->size < 1 || this->size > 8) {
+			throw std::runtime_error("Invalid size " + std::to_string(this->size));
+		}
 
-		//Now we read the rest of the file.
+		//Now we read the grid, one line for every row.
 		//The format is the following:
 		//A|B|C|D|E...
 		//A number different than -1 indicated a found value
@@ -64,7 +103,7 @@ Sudoku::Sudoku(std::string fileName) {
 		//Used to save the position of the cell
 		int positionX = 0;
 		int positionY = 0;
-		while (std::getline(file, line)) {
+		while (positionY < this->size * this->size && std::getline(file, line)) {
 			std::vector<std::string> lineParts = this->splitString(line, "|");
 			for (std::string linepart : lineParts) {
 				this->cells.push_back(new Cell(std::atoi(linepart.c_str()), positionX, positionY, this->size * this->size));
@@ -86,15 +125,22 @@ Sudoku::Sudoku(std::string fileName) {
 		//Used to save the current position of the cell
 		int positionY = 0;
 		while (std::getline(file, line)) {
-			if (line[0] != '#') {
+			//We remove the carriage return of Windows files
+			if (!line.empty() && line.at(line.size() - 1) == '\r') {
+				line.erase(line.size() - 1);
+			}
+			if (!line.empty() && line[0] != '#') {
 				for (int i = 0; i < line.size(); i++) {
 					char aux = line.at(i);
 					int value;
 					if (aux == '.') {
 						value = -1;
 					}
+					else if (aux >= '1' && aux <= '9') {
+						value = aux - '0';
+					}
 					else {
-						value = std::atoi(&aux);
+						throw std::runtime_error(std::string("Invalid character in sudoku: ") + aux);
 					}
 					this->cells.push_back(new Cell(value, i, positionY, this->size * this->size));
 					
@@ -111,27 +157,140 @@ Sudoku::Sudoku(std::string fileName) {
 
 		//We get the line
 		std::getline(file, line);
+		if (line.size() < this->size * this->size * this->size * this->size) {
+			throw std::runtime_error("The sudoku line is too short");
+		}
 
 		for (int j = 0; j < this->size * this->size; j++) {
 			for (int i = 0; i < this->size * this->size; i++) {
 				char aux = line.at(i + this->size * this->size * j);
-				int value = std::atoi(&aux);
-				if (value == 0) {
+				int value;
+				if (aux == '0' || aux == '.') {
 					value = -1;
 				}
+				else if (aux >= '1' && aux <= '9') {
+					value = aux - '0';
+				}
+				else {
+					throw std::runtime_error(std::string("Invalid character in sudoku: ") + aux);
+				}
 				this->cells.push_back(new Cell(value, i, j, this->size * this->size));
 			}
 		}
 	}
+
+	else {
+		throw std::runtime_error("Unknown file format: " + fileName);
+	}
+
+	//We check the grid before building its layout, as a broken file could have any amount of cells
+	this->checkGrid();
+
+	//The rest of the file can have the constraints of variant sudokus
+	this->layout = std::make_shared<Layout>(this->size);
+	if (hasConstraints) {
+		this->readConstraints(file);
+		this->layout->compile();
+	}
+}
+
+void Sudoku::checkGrid() {
+	int sideLength = this->size * this->size;
+	if (this->cells.size() != sideLength * sideLength) {
+		throw std::runtime_error("The sudoku must have " + std::to_string(sideLength * sideLength) + " cells, found " + std::to_string(this->cells.size()));
+	}
+
+	for (int cell = 0; cell < this->cells.size(); cell++) {
+		Cell* currentCell = this->cells.at(cell);
+		//Every row must have the same amount of cells
+		if (currentCell->getPositionX() != cell % sideLength || currentCell->getPositionY() != cell / sideLength) {
+			throw std::runtime_error("Row " + std::to_string(currentCell->getPositionY() + 1) + " doesn't have " + std::to_string(sideLength) + " cells");
+		}
+		int value = currentCell->getValue();
+		if (value != -1 && (value < 1 || value > sideLength)) {
+			throw std::runtime_error("Invalid number " + std::to_string(value));
+		}
+	}
+}
+
+void Sudoku::readConstraints(std::ifstream& file) {
+	//Each constraint is on its own line:
+	//regions             Followed by one line for every row with the region of each cell: A|B|C...
+	//diagonals           Both diagonals can't repeat numbers
+	//nonconsecutive      Orthogonally adjacent cells can't have consecutive numbers
+	//cage|SUM|X,Y|X,Y... Killer cage with its sum and its cells
+	std::string line;
+	while (std::getline(file, line)) {
+		//We remove the carriage return of Windows files
+		if (!line.empty() && line.at(line.size() - 1) == '\r') {
+			line.erase(line.size() - 1);
+		}
+
+		std::vector<std::string> lineParts = this->splitString(line, "|");
+		std::string constraint = lineParts.at(0);
+		if (constraint.empty()) {
+			continue;
+		}
+		else if (constraint.compare("regions") == 0) {
+			//The regions can be numbered in any way, we number them in the order they appear
+			std::vector<int> regionOfCell;
+			std::vector<int> regionIds;
+			for (int positionY = 0; positionY < this->size * this->size && std::getline(file, line); positionY++) {
+				for (std::string linepart : this->splitString(line, "|")) {
+					int regionId = std::atoi(linepart.c_str());
+					std::vector<int>::iterator found = std::find(regionIds.begin(), regionIds.end(), regionId);
+					if (found == regionIds.end()) {
+						regionIds.push_back(regionId);
+						found = regionIds.end() - 1;
+					}
+					regionOfCell.push_back(found - regionIds.begin());
+				}
+			}
+			this->layout->setRegions(regionOfCell);
+		}
+		else if (constraint.compare("diagonals") == 0) {
+			this->layout->addDiagonals();
+		}
+		else if (constraint.compare("nonconsecutive") == 0) {
+			this->layout->setNonConsecutive();
+		}
+		else if (constraint.compare("cage") == 0 && lineParts.size() > 2) {
+			std::vector<int> cageCells;
+			for (int i = 2; i < lineParts.size(); i++) {
+				std::vector<std::string> position = this->splitString(lineParts.at(i), ",");
+				if (position.size() != 2) {
+					throw std::runtime_error("Invalid cage cell: " + lineParts.at(i));
+				}
+				int positionX = std::atoi(position.at(0).c_str());
+				int positionY = std::atoi(position.at(1).c_str());
+				if (positionX < 0 || positionX >= this->size * this->size || positionY < 0 || positionY >= this->size * this->size) {
+					throw std::runtime_error("Cage cell outside of the sudoku: " + lineParts.at(i));
+				}
+				cageCells.push_back(positionX + this->size * this->size * positionY);
+			}
+			//std::atoi doesn't detect numbers that don't fit in an int
+			char* end;
+			long sum = std::strtol(lineParts.at(1).c_str(), &end, 10);
+			if (end == lineParts.at(1).c_str() || *end != '\0' || sum < INT_MIN || sum > INT_MAX) {
+				throw std::runtime_error("Invalid cage sum: " + lineParts.at(1));
+			}
+			this->layout->addCage(sum, cageCells);
+		}
+		else {
+			throw std::runtime_error("Unknown constraint: " + line);
+		}
+	}
 }
 
 void Sudoku::print() {
 	int currentColumn = 0;
 	//Size of the strings to print. Used just to prettify
 	int columnStringSize = std::to_string(this->size*this->size).length();
+	//Every how many columns and rows we draw a separator. Irregular regions can't be drawn this way, so we only draw the border
+	int subSquareSize = this->layout->hasRectangularRegions() ? this->size : this->size * this->size;
 
 	//We start by drawing a line of -. First we determine the amount to draw 
-	int amountToDraw = this->size * this->size * (columnStringSize + 1) + (this->size + 1) * 2 - 1;
+	int amountToDraw = this->size * this->size * (columnStringSize + 1) + (this->size * this->size / subSquareSize + 1) * 2 - 1;
 	for (int i = 0; i < amountToDraw; i++) {
 		std::cout << "-";
 	}
@@ -160,7 +319,7 @@ void Sudoku::print() {
 			std::cout << valueString;
 		}
 		//We check if we have to draw a column separating the sub-squares
-		if ((currentCell->getPositionX() + 1) % this->size == 0) {
+		if ((currentCell->getPositionX() + 1) % subSquareSize == 0) {
 			std::cout << " | ";
 		}
 		else {
@@ -168,7 +327,7 @@ void Sudoku::print() {
 		}
 
 		//We check if we are at the last column. If so, we draw a line of - if we have to
-		if (currentCell->getPositionX() == this->size * this->size - 1 && (currentCell->getPositionY() + 1) % this->size == 0) {
+		if (currentCell->getPositionX() == this->size * this->size - 1 && (currentCell->getPositionY() + 1) % subSquareSize == 0) {
 			//We draw a new line
 			std::cout << "\n";
 
@@ -186,38 +345,55 @@ void Sudoku::print() {
 	}
 }
 
-void Sudoku::solve() {
-	//First we prepare all the cells to eliminate the possible values that are already in that subsquare, row and column
-	for (int i = 0; i < this->size * this->size; i++) {
-		for (int j = 0; j < this->size * this->size; j++) {
-			Cell* currentCell = this->getCellAt(i, j);
-			if (currentCell->valueSet()) {
-				//We have to remove the value of this cell from all the others in the possible vector
-				int currentCellValue = currentCell->getValue();
+SolveResult Sudoku::solve() {
+	return this->solve(SolveLimits());
+}
 
-				//We remove it from the row
-				std::vector<Cell*> row = this->getRowAt(j);
-				for (Cell* rowCell : row) {
-					rowCell->removeFromPossibleValues(currentCellValue);
-				}
+SolveResult Sudoku::solve(SolveLimits limits) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-				//We remove it from the column
-				std::vector<Cell*> column = this->getColumnAt(i);
-				for (Cell* columnCell : column) {
-					columnCell->removeFromPossibleValues(currentCellValue);
-				}
+	SolveResult result;
+	result.nodes = 0;
+	std::vector<int> solution;
 
-				//We remove it from the subSquare
-				std::vector<Cell*> subSquare = this->getSubSquare(i,j);
-				for (Cell* subSquareCell : subSquare) {
-					subSquareCell->removeFromPossibleValues(currentCellValue);
-				}
-			}
+	//First we prepare all the cells to eliminate the possible values that are already in their peers.
+	//On big sudokus this takes a while, so we also check the deadline here
+	for (int cell = 0; cell < this->cells.size(); cell++) {
+		if (cell % budgetCheckInterval == 0 && this->deadlinePassed(limits)) {
+			result.status = SolveStatus::BudgetExceeded;
+			result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+			return result;
+		}
+		Cell* currentCell = this->cells.at(cell);
+		if (currentCell->valueSet()) {
+			//We have to remove the value of this cell from all the others in the possible vector
+			this->eliminateFromPeers(cell, currentCell->getValue());
 		}
 	}
+	this->pruneCages();
 
-	this->print();
+	if (this->deadlinePassed(limits)) {
+		result.status = SolveStatus::BudgetExceeded;
+	}
+	else if (this->solvable()) {
+		result.status = this->search(limits, result.nodes, solution);
+	}
+	else {
+		result.status = SolveStatus::Unsolvable;
+	}
 
+	//The solution was found on a guessed sudoku, so we copy it
+	if (!solution.empty()) {
+		for (int cell = 0; cell < this->cells.size(); cell++) {
+			this->cells.at(cell)->setValue(solution.at(cell));
+		}
+	}
+
+	result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	return result;
+}
+
+SolveStatus Sudoku::search(SolveLimits& limits, long& nodes, std::vector<int>& solution) {
 	//We check how many loops have been made without a change
 	int amountOfLoopsWithoutChange = 0;
 
@@ -227,28 +403,14 @@ void Sudoku::solve() {
 		//We increment the counter
 		amountOfLoopsWithoutChange++;
 
-		/*
-		//TODO Debug, Remove
-		this->print();
-		for (int i = 0; i < this->size * this->size; i++) {
-			for (int j = 0; j < this->size * this->size; j++) {
-				Cell* currentCell = this->getCellAt(i, j);
-
-				if (!currentCell->valueSet()) {
-					std::cout << currentCell->getPositionX();
-					std::cout << "|";
-					std::cout << currentCell->getPositionY();
-					std::cout << "\n";
-
-					std::vector<int> possibleValues = currentCell->getPossibleValues();
-					for (int aux : possibleValues) {
-						std::cout << aux;
-						std::cout << ";";
-					}
-					std::cout << "\n";
-				}
-			}
-		}*/
+		//Every loop counts as a node. Reading the clock is cheap compared to a loop, so we check the deadline on each one
+		nodes++;
+		if (limits.maxNodes != 0 && nodes > limits.maxNodes) {
+			return SolveStatus::BudgetExceeded;
+		}
+		if (this->deadlinePassed(limits)) {
+			return SolveStatus::BudgetExceeded;
+		}
 
 		//First we check if there is a cell that only has one value in it. If so, we put it in
 		for (int i = 0; i < this->size * this->size; i++) {
@@ -261,240 +423,225 @@ void Sudoku::solve() {
 			}
 		}
 
-		//Now we check if there is a row/column/sub-square that has a missing number only possible on a single cell
-
-		//We check the rows
-		for (int i = 0; i < this->size * this->size; i++) {
-			//We get the row
-			std::vector<Cell*> row = this->getRowAt(i);
-
+		//Now we check if there is a unit (row, column, region or diagonal) that has a missing number only possible on a single cell.
+		//A single loop can take long on big sudokus, so we check the deadline every few units
+		std::vector<std::vector<int>>& units = this->layout->getUnits();
+		for (int unitIndex = 0; unitIndex < units.size(); unitIndex++) {
+			if (unitIndex % budgetCheckInterval == 0 && this->deadlinePassed(limits)) {
+				return SolveStatus::BudgetExceeded;
+			}
+			std::vector<int>& unit = units.at(unitIndex);
 			//We check for all numbers
 			for (int j = 1; j <= this->size * this->size; j++) {
 				//We have to check how many have the number in their possibles
 				int cellsWithNumberInPossibles = 0;
 
-				//This is made just to make it faster. We save the position of the last one with the number in possibles. If it's only one, we have already it's position
+				//This is made just to make it faster. We save the last one with the number in possibles. If it's only one, we have already it's position
 				int cellWithPossible = -1;
 
-				//We have to get it's position
-				int currentPosition = 0;
-				for (Cell* currentCell : row) {
-					if (!currentCell->valueSet()) {
-						if (currentCell->valueInPossibles(j)) {
-							cellsWithNumberInPossibles++;
-							cellWithPossible = currentPosition;
-						}
+				for (int cell : unit) {
+					if (this->cells.at(cell)->valueInPossibles(j)) {
+						cellsWithNumberInPossibles++;
+						cellWithPossible = cell;
 					}
-					currentPosition++;
 				}
 
 				//We now check if it's only one cell with that number in possibles
 				if (cellsWithNumberInPossibles == 1) {
-					this->setValueForCell(cellWithPossible, i, j);
+					this->setValueForCell(cellWithPossible % (this->size * this->size), cellWithPossible / (this->size * this->size), j);
 					amountOfLoopsWithoutChange = 0;
 				}
 			}
 		}
 
-		//We check the columns
-		for (int i = 0; i < this->size * this->size; i++) {
-			//We get the row
-			std::vector<Cell*> column = this->getColumnAt(i);
-
-			//We check for all numbers
-			for (int j = 1; j <= this->size * this->size; j++) {
-				//We have to check how many have the number in their possibles
-				int cellsWithNumberInPossibles = 0;
-
-				//This is made just to make it faster. We save the position of the last one with the number in possibles. If it's only one, we have already it's position
-				int cellWithPossible = -1;
+		//Next, we check if there is a unit in which a number is only possible in the cells it shares with another unit.
+		//If so, we have to remove it from the rest of that other unit. For standard sudokus these are the sub-squares against their rows and columns
+		std::vector<UnitIntersection>& intersections = this->layout->getIntersections();
+		for (int intersectionIndex = 0; intersectionIndex < intersections.size(); intersectionIndex++) {
+			if (intersectionIndex % budgetCheckInterval == 0 && this->deadlinePassed(limits)) {
+				return SolveStatus::BudgetExceeded;
+			}
+			UnitIntersection& intersection = intersections.at(intersectionIndex);
+			for (int direction = 0; direction < 2; direction++) {
+				std::vector<int>& checkedUnit = this->layout->getUnits().at(direction == 0 ? intersection.firstUnit : intersection.secondUnit);
+				std::vector<int>& otherUnit = this->layout->getUnits().at(direction == 0 ? intersection.secondUnit : intersection.firstUnit);
+				std::vector<bool>& sharedInChecked = direction == 0 ? intersection.sharedInFirst : intersection.sharedInSecond;
+				std::vector<bool>& sharedInOther = direction == 0 ? intersection.sharedInSecond : intersection.sharedInFirst;
+
+				for (int value = 1; value <= this->size * this->size; value++) {
+					bool valueInShared = false;
+					bool valueOutsideShared = false;
+					for (int position = 0; position < checkedUnit.size(); position++) {
+						if (this->cells.at(checkedUnit.at(position))->valueInPossibles(value)) {
+							if (sharedInChecked.at(position)) {
+								valueInShared = true;
+							}
+							else {
+								valueOutsideShared = true;
+							}
+						}
+					}
 
-				//We have to get it's position
-				int currentPosition = 0;
-				for (Cell* currentCell : column) {
-					if (!currentCell->valueSet()) {
-						if (currentCell->valueInPossibles(j)) {
-							cellsWithNumberInPossibles++;
-							cellWithPossible = currentPosition;
+					//If it's only possible in the shared cells, we remove it from the rest of the other unit
+					if (valueInShared && !valueOutsideShared) {
+						for (int position = 0; position < otherUnit.size(); position++) {
+							Cell* otherCell = this->cells.at(otherUnit.at(position));
+							if (!sharedInOther.at(position) && otherCell->valueInPossibles(value)) {
+								otherCell->removeFromPossibleValues(value);
+								amountOfLoopsWithoutChange = 0;
+							}
 						}
 					}
-					currentPosition++;
 				}
+			}
+		}
 
-				//We now check if it's only one cell with that number in possibles
-				if (cellsWithNumberInPossibles == 1) {
-					this->setValueForCell(i, cellWithPossible, j);
-					amountOfLoopsWithoutChange = 0;
+		//We remove the numbers that can't reach the sum of their cage
+		if (this->pruneCages()) {
+			amountOfLoopsWithoutChange = 0;
+		}
+
+		if (amountOfLoopsWithoutChange == 2) {
+			if (this->deadlinePassed(limits)) {
+				return SolveStatus::BudgetExceeded;
+			}
+			if (!this->solvable()) {
+				return SolveStatus::Unsolvable;
+			}
+
+			//We are going to guess a number. We pick the vacant cell with the fewest possible values,
+			//and create a new Sudoku for each of them. If none of them works, the sudoku has no solution
+			Cell* guessedCell = nullptr;
+			for (Cell* cell : this->cells) {
+				if (!cell->valueSet() && (guessedCell == nullptr || cell->getPossibleValues().size() < guessedCell->getPossibleValues().size())) {
+					guessedCell = cell;
 				}
 			}
-		}
 
-		//We check the subsquare
-		for (int i = 0; i < this->size * this->size; i++) {
-			for (int j = 0; j < this->size * this->size; j++) {
-				std::vector<Cell*> subSquare = this->getSubSquare(i, j);
-
-				//We check for all numbers
-				for (int z = 1; z <= this->size * this->size; z++) {
-					//We have to check how many have the number in their possibles
-					int cellsWithNumberInPossibles = 0;
-
-					//This is made just to make it faster. We save the position of the last one with the number in possibles. If it's only one, we have already it's position
-					int cellWithPossibleX = -1;
-					int cellWithPossibleY = -1;
-
-					for (Cell* currentCell : subSquare) {
-						if (!currentCell->valueSet()) {
-							if (currentCell->valueInPossibles(j)) {
-								cellsWithNumberInPossibles++;
-								cellWithPossibleX = currentCell->getPositionX();
-								cellWithPossibleY = currentCell->getPositionY();
-							}
-						}
-					}
+			bool found = false;
+			for (int z : guessedCell->getPossibleValues()) {
+				Sudoku* sudoku = new Sudoku(this->cells, this->size, this->layout);
+				sudoku->setValueForCell(guessedCell->getPositionX(), guessedCell->getPositionY(), z);
+				SolveStatus status = SolveStatus::Unsolvable;
+				if (sudoku->solvable()) {
+					status = sudoku->search(limits, nodes, solution);
+				}
+				delete(sudoku);
 
-					//We now check if it's only one cell with that number in possibles
-					if (cellsWithNumberInPossibles == 1) {
-						this->setValueForCell(cellWithPossibleX, cellWithPossibleY, j);
-						amountOfLoopsWithoutChange = 0;
+				if (status == SolveStatus::Solved) {
+					found = true;
+					//If we don't have to check that it's the only solution, we can stop here
+					if (!limits.checkUniqueness) {
+						return SolveStatus::Solved;
 					}
 				}
+				else if (status != SolveStatus::Unsolvable) {
+					return status;
+				}
 			}
+			return found ? SolveStatus::Solved : SolveStatus::Unsolvable;
 		}
-		
-		
-		//Next, we check if there is a subsquare, in which a number is only possible in one of it's columns/rows. If so, we have to remove it from the rest of subsquares of that row/column
-		//We iterate through all subsquares
-		for (int i = 0; i < this->size * this->size; i = i + this->size) {
-			for (int j = 0; j < this->size * this->size; j = j + this->size) {
-
-				//We are on the top-left cell of the subsquare. We start by checking if it's row has a unique value in it's possibles cells
-				for (int z = 0; z < this->size; z++) {
-					for (int t = 0; t < this->size; t++) {
-						//We get the next checked cell
-						//NOTE: We are currently on the column z and row t inside the sub-square
-						Cell* currentCell = this->getCellAt(i + z, j + t);
-						if (!currentCell->valueSet()) {
-							//We get it's possible values
-							std::vector<int> possibleValuesOfCell = currentCell->getPossibleValues();
-
-							//We have to iterate now over this vector. We check if a value is present on other rows inside the cell
-							for (int currentValue : possibleValuesOfCell) {
-								bool valueInOtherRows = false;
-								for (int u = 0; u < this->size; u++) {
-									for (int v = 0; v < this->size; v++) {
-										//We are currently checking the subsquare. First we have to make sure we aren't checking the same row
-										//NOTE: We are currently comparing row u and column v
-										if (t != v) {
-											//We get the cell
-											Cell* comparedCellInSubSquare = this->getCellAt(i + u, j + v);
-											if (!comparedCellInSubSquare->valueSet() && comparedCellInSubSquare->valueInPossibles(currentValue)) {
-												valueInOtherRows = true;
-											}
-										}
-									}
-								}
-								//We have now checked all other rows in the subsquare. If it isn't in other rows, we must eliminate it from the rest of the possible in that row in other subsquares
-								if (!valueInOtherRows) {
-									int row = j + t;
-									for (int u = 0; u < i; u++) {
-										Cell* cell = this->getCellAt(u, row);
-										if (!cell->valueSet() && cell->valueInPossibles(currentValue)) {
-											cell->removeFromPossibleValues(currentValue);
-											amountOfLoopsWithoutChange = 0;
-										}
-									}
-									//We divide in 2 fors to skip over the ones in the subsquare
-									for (int u = i + this->size; u < this->size * this->size; u++) {
-										Cell* cell = this->getCellAt(u, row);
-										if (!cell->valueSet() && cell->valueInPossibles(currentValue)) {
-											cell->removeFromPossibleValues(currentValue);
-											amountOfLoopsWithoutChange = 0;
-										}
-									}
-								}
-							}
-						}
-					}
-				}
+	}
 
-				//We repeat for the columns
-				for (int z = 0; z < this->size; z++) {
-					for (int t = 0; t < this->size; t++) {
-						//We get the next checked cell
-						//NOTE: We are currently on the row z and column t inside the sub-square
-						Cell* currentCell = this->getCellAt(i + z, j + t);
-						if (!currentCell->valueSet()) {
-							//We get it's possible values
-							std::vector<int> possibleValuesOfCell = currentCell->getPossibleValues();
-
-							//We have to iterate now over this vector. We check if a value is present on other rows inside the cell
-							for (int currentValue : possibleValuesOfCell) {
-								bool valueInOtherColumns = false;
-								for (int u = 0; u < this->size; u++) {
-									for (int v = 0; v < this->size; v++) {
-										//We are currently checking the subsquare. First we have to make sure we aren't checking the same row
-										//NOTE: We are currently comparing row u and column v
-										if (u != z) {
-											//We get the cell
-											Cell* comparedCellInSubSquare = this->getCellAt(i + u, j + v);
-											if (!comparedCellInSubSquare->valueSet() && comparedCellInSubSquare->valueInPossibles(currentValue)) {
-												valueInOtherColumns = true;
-											}
-										}
-									}
-								}
-								//We have now checked all other rows in the subsquare. If it isn't in other rows, we must eliminate it from the rest of the possible in that row in other subsquares
-								if (!valueInOtherColumns) {
-									int column = i + z;
-									for (int u = 0; u < j; u++) {
-										Cell* cell = this->getCellAt(column, u);
-										if (!cell->valueSet() && cell->valueInPossibles(currentValue)) {
-											cell->removeFromPossibleValues(currentValue);
-											amountOfLoopsWithoutChange = 0;
-										}
-									}
-									//We divide in 2 fors to skip over the ones in the subsquare
-									for (int u = j + this->size; u < this->size * this->size; u++) {
-										Cell* cell = this->getCellAt(column, u);
-										if (!cell->valueSet() && cell->valueInPossibles(currentValue)) {
-											cell->removeFromPossibleValues(currentValue);
-											amountOfLoopsWithoutChange = 0;
-										}
-									}
-								}
-							}
+	//A full sudoku can still break a killer cage
+	if (!this->solvable()) {
+		return SolveStatus::Unsolvable;
+	}
+
+	//We save the solution. If there was already one, the sudoku has more than one
+	if (!solution.empty()) {
+		return SolveStatus::MultipleSolutions;
+	}
+	for (Cell* cell : this->cells) {
+		solution.push_back(cell->getValue());
+	}
+	return SolveStatus::Solved;
+}
+
+bool Sudoku::deadlinePassed(SolveLimits& limits) {
+	return limits.deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() > limits.deadline;
+}
+
+void Sudoku::eliminateFromPeers(int cell, int value) {
+	for (int peer : this->layout->getPeers(cell)) {
+		this->cells.at(peer)->removeFromPossibleValues(value);
+	}
+
+	//On non-consecutive sudokus, the adjacent cells can't have the previous or next number
+	for (int neighbour : this->layout->getNeighbours(cell)) {
+		this->cells.at(neighbour)->removeFromPossibleValues(value - 1);
+		this->cells.at(neighbour)->removeFromPossibleValues(value + 1);
+	}
+}
+
+bool Sudoku::pruneCages() {
+	bool changed = false;
+
+	for (Cage& cage : this->layout->getCages()) {
+		//We get what is left of the sum, and which cells are still vacant
+		int remainingSum = cage.sum;
+		std::vector<bool> usedValues(this->size * this->size + 1, false);
+		std::vector<int> vacantCells;
+		for (int cell : cage.cells) {
+			Cell* currentCell = this->cells.at(cell);
+			if (currentCell->valueSet()) {
+				remainingSum -= currentCell->getValue();
+				usedValues.at(currentCell->getValue()) = true;
+			}
+			else {
+				vacantCells.push_back(cell);
+			}
+		}
+
+		for (int cell : vacantCells) {
+			//We get the numbers the rest of vacant cells could use
+			std::vector<bool> othersPossible(this->size * this->size + 1, false);
+			for (int other : vacantCells) {
+				if (other != cell) {
+					for (int value : this->cells.at(other)->getPossibleValues()) {
+						if (!usedValues.at(value)) {
+							othersPossible.at(value) = true;
 						}
 					}
 				}
 			}
-		}
 
-		if (amountOfLoopsWithoutChange == 2) {
-			//We are going to guess a number. To do this we are going to iterate over all possible values
-			//and create a new Sudoku from it
-			for (int i = 0; i < this->size * this->size; i++) {
-				for (int j = 0; j < this->size * this->size; j++) {
-					Cell* cell = this->getCellAt(i, j);
-					if (!cell->valueSet()) {
-						for (int z : cell->getPossibleValues()) {
-							Sudoku* sudoku = new Sudoku(this->cells, this->size);
-							sudoku->setValueForCell(i, j, z);
-							if (sudoku->solvable()) {
-								sudoku->solve();
-								if (sudoku->solved()) {
-									this->cells = sudoku->cells;
-									return;
-								}
-							}
-							delete(sudoku);
-						}
+			for (int value : this->cells.at(cell)->getPossibleValues()) {
+				//The rest of the vacant cells have to add up to the remaining sum using different numbers.
+				//We get the minimum and maximum they could reach
+				int amountOfOthers = vacantCells.size() - 1;
+				int minimumSum = 0;
+				int maximumSum = 0;
+				int found = 0;
+				for (int other = 1; other <= this->size * this->size && found < amountOfOthers; other++) {
+					if (other != value && othersPossible.at(other)) {
+						minimumSum += other;
+						found++;
 					}
 				}
+				bool reachable = found == amountOfOthers;
+				found = 0;
+				for (int other = this->size * this->size; other >= 1 && found < amountOfOthers; other--) {
+					if (other != value && othersPossible.at(other)) {
+						maximumSum += other;
+						found++;
+					}
+				}
+
+				int sumNeeded = remainingSum - value;
+				if (usedValues.at(value) || !reachable || sumNeeded < minimumSum || sumNeeded > maximumSum) {
+					this->cells.at(cell)->removeFromPossibleValues(value);
+					changed = true;
+				}
 			}
-			return;
 		}
 	}
+
+	return changed;
+}
+
+int Sudoku::getSize() {
+	return this->size;
 }
 
 Cell* Sudoku::getCellAt(int positionX, int positionY) {
@@ -518,15 +665,12 @@ std::vector<Cell*> Sudoku::getColumnAt(int positionX) {
 }
 
 std::vector<Cell*> Sudoku::getSubSquare(int positionX, int positionY) {
-	//We get which sub-square in the columns and rows we have to get
-	int subSquareColumn = positionX / this->size;
-	int subSquareRow = positionY / this->size;
+	//We get the region of the cell. For standard sudokus it's the sub-square
+	int region = this->layout->getRegionOfCell(positionX + this->size * this->size * positionY);
 
 	std::vector<Cell*> output;
-	for (int i = 0; i < this->size; i++) {
-		for (int j = 0; j < this->size; j++) {
-			output.push_back(this->getCellAt(subSquareColumn * this->size + i, subSquareRow * this->size + j));
-		}
+	for (int cell : this->layout->getUnits().at(2 * this->size * this->size + region)) {
+		output.push_back(this->cells.at(cell));
 	}
 	return output;
 }
@@ -545,26 +689,12 @@ bool Sudoku::solved() {
 	
 void Sudoku::setValueForCell(int positionX, int positionY, int value) {
 	//We set the value
-	this->getCellAt(positionX, positionY)->setValue(value);
+	Cell* cell = this->getCellAt(positionX, positionY);
+	cell->setValue(value);
+	cell->removeFromPossibleValues(value);
 
-	//We have to remove the value of this cell from all the others in the possible vector
-	//We remove it from the row
-	std::vector<Cell*> row = this->getRowAt(positionY);
-	for (Cell* rowCell : row) {
-		rowCell->removeFromPossibleValues(value);
-	}
-
-	//We remove it from the column
-	std::vector<Cell*> column = this->getColumnAt(positionX);
-	for (Cell* columnCell : column) {
-		columnCell->removeFromPossibleValues(value);
-	}
-
-	//We remove it from the subSquare
-	std::vector<Cell*> subSquare = this->getSubSquare(positionX, positionY);
-	for (Cell* subSquareCell : subSquare) {
-		subSquareCell->removeFromPossibleValues(value);
-	}
+	//We have to remove the value of this cell from all its peers
+	this->eliminateFromPeers(positionX + this->size * this->size * positionY, value);
 }
 
 bool Sudoku::solvable() {
@@ -577,5 +707,40 @@ bool Sudoku::solvable() {
 			}
 		}
 	}
+
+	//The numbers already set can't repeat on their peers or be consecutive to their neighbours
+	for (int cell = 0; cell < this->cells.size(); cell++) {
+		int value = this->cells.at(cell)->getValue();
+		if (value != -1) {
+			for (int peer : this->layout->getPeers(cell)) {
+				if (this->cells.at(peer)->getValue() == value) {
+					solvable = false;
+				}
+			}
+			for (int neighbour : this->layout->getNeighbours(cell)) {
+				int neighbourValue = this->cells.at(neighbour)->getValue();
+				if (neighbourValue != -1 && (neighbourValue == value - 1 || neighbourValue == value + 1)) {
+					solvable = false;
+				}
+			}
+		}
+	}
+
+	//The killer cages that are already full must add up to their sum
+	for (Cage& cage : this->layout->getCages()) {
+		int sum = 0;
+		bool full = true;
+		for (int cell : cage.cells) {
+			if (this->cells.at(cell)->valueSet()) {
+				sum += this->cells.at(cell)->getValue();
+			}
+			else {
+				full = false;
+			}
+		}
+		if (full && sum != cage.sum) {
+			solvable = false;
+		}
+	}
 	return solvable;
 }
\ No newline at end of file
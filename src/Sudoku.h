@@ -1,37 +1,96 @@
 #pragma once
 
+#include <chrono>
 #include <fstream>
+#include <memory>
+#include <string>
 #include <vector>
 
 class Cell;
+class Layout;
+
+enum class SolveStatus {
+	Solved,
+	Unsolvable,
+	MultipleSolutions,
+	BudgetExceeded
+};
+
+//Limits for a call to solve
+struct SolveLimits {
+	//Time at which the solver gives up
+	std::chrono::steady_clock::time_point deadline;
+	//Maximum amount of nodes (propagation loops and guesses). 0 means no limit
+	long maxNodes;
+	//Keeps searching after the first solution to check that it's the only one
+	bool checkUniqueness;
+
+	SolveLimits() : deadline(std::chrono::steady_clock::time_point::max()), maxNodes(0), checkUniqueness(false) {}
+};
+
+struct SolveResult {
+	SolveStatus status;
+	//Amount of nodes searched
+	long nodes;
+	std::chrono::microseconds elapsed;
+};
 
 class Sudoku {
 private:
+	//Amount of cells, units or intersections handled between two checks of the deadline
+	static const int budgetCheckInterval = 8;
+
 	//Cells of the sudoku
 	std::vector<Cell*> cells;
 	//Number of columns in one subquare
 	int size;
+	//Units and constraints of the sudoku. Shared with the sudokus created when guessing
+	std::shared_ptr<Layout> layout;
 
 	//Splits string
 	std::vector<std::string> splitString(std::string string, std::string splitter);
+	//Reads the sudoku from the file. Throws std::runtime_error if the file can't be read
+	void readFile(std::string fileName);
+	//Checks that the loaded grid has the right amount of cells and numbers. Throws std::runtime_error if not
+	void checkGrid();
+	//Reads the constraints after the grid on .sudoku files
+	void readConstraints(std::ifstream& file);
+	//Solves the sudoku, guessing when it gets stuck. The first solution found is saved in solution
+	SolveStatus search(SolveLimits& limits, long& nodes, std::vector<int>& solution);
+	//Removes the value from the peers of the cell, and its consecutive numbers from its neighbours if needed
+	void eliminateFromPeers(int cell, int value);
+	//Removes the numbers that can't reach the sum of their killer cage. Returns true if something was removed
+	bool pruneCages();
+	//Indicates if the deadline of the limits has passed
+	bool deadlinePassed(SolveLimits& limits);
 public:
 	Sudoku(std::string file);
 	Sudoku(std::vector<Cell*> cells, int size);
+	//Sudoku with the constraints of the layout, which has to be compiled already
+	Sudoku(std::vector<Cell*> cells, int size, std::shared_ptr<Layout> layout);
+	~Sudoku();
+	//The cells are owned by the sudoku, so it can't be copied
+	Sudoku(const Sudoku&) = delete;
+	Sudoku& operator=(const Sudoku&) = delete;
 	//Prints the current sudoku to terminal
 	void print();
 	//Solves the Sudoku
-	void solve();
+	SolveResult solve();
+	//Solves the Sudoku, giving up when the deadline or the maximum amount of nodes is reached
+	SolveResult solve(SolveLimits limits);
+	//Gives the number of columns in one sub-square
+	int getSize();
 	//Gives the cell at that position
 	Cell* getCellAt(int positionX, int positionY);
 	//Gives the row of the cell
 	std::vector<Cell*> getRowAt(int positionY);
 	//Gives the row of the cell
 	std::vector<Cell*> getColumnAt(int positionX);
-	//Gives the sub-square of the cell
+	//Gives the sub-square of the cell. On jigsaw sudokus it's the irregular region of the cell
 	std::vector<Cell*> getSubSquare(int positionX, int positionY);
 	//Indicates if it has been solved
 	bool solved();
-	//Function to put a number in and eliminate its new value from row, column and sub-square
+	//Function to put a number in and eliminate its new value from all its peers
 	void setValueForCell(int positionX, int positionY, int value);
 	//Indicates if it's still solvable
 	bool solvable();
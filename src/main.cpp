@@ -1,8 +1,140 @@
+#include "BatchSolver.h"
 #include "Sudoku.h"
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+std::string statusToString(SolveStatus status) {
+	switch (status) {
+	case SolveStatus::Solved:
+		return "Solved";
+	case SolveStatus::Unsolvable:
+		return "Unsolvable";
+	case SolveStatus::MultipleSolutions:
+		return "Multiple solutions";
+	default:
+		return "Budget exceeded";
+	}
+}
+
+//Solves a file with one 9x9 sudoku per line, in the .sdkstring format. Writes the solution of each one,
+//or why it couldn't be solved, in the same order
+int solveBatch(std::string fileName, SolveLimits limits, std::chrono::milliseconds timeout) {
+	std::ifstream file;
+	file.open(fileName);
+	if (!file.is_open()) {
+		std::cerr << "Can't open " << fileName << "\n";
+		return 1;
+	}
+
+	BatchSolver batchSolver(limits, timeout);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	long amount = 0;
+	bool allSolved = true;
+
+	//We read the file in blocks, so big files don't have to fit in memory
+	const int blockSize = 4096;
+	std::string line;
+	while (!file.eof()) {
+		std::vector<uint16_t> sudokus;
+		//The invalid and blank lines are kept so the output has one line per input line
+		std::vector<bool> valid;
+		std::vector<bool> blank;
+		while (valid.size() < blockSize && std::getline(file, line)) {
+			uint16_t cells[81];
+			blank.push_back(line.empty() || line == "\r");
+			valid.push_back(!blank.back() && BitboardSolver::parse(line, cells));
+			if (valid.back()) {
+				sudokus.insert(sudokus.end(), cells, cells + 81);
+			}
+		}
+
+		std::vector<SolveStatus> statuses = batchSolver.solve(sudokus);
+		int solvedIndex = 0;
+		for (int i = 0; i < valid.size(); i++) {
+			//Blank lines get a blank output line, and don't count as sudokus
+			if (blank.at(i)) {
+				std::cout << "\n";
+				continue;
+			}
+			amount++;
+			if (!valid.at(i)) {
+				std::cout << "Invalid\n";
+				allSolved = false;
+				continue;
+			}
+
+			SolveStatus status = statuses.at(solvedIndex);
+			if (status == SolveStatus::Solved) {
+				std::cout << BitboardSolver::toString(sudokus.data() + solvedIndex * 81) << "\n";
+			}
+			else {
+				std::cout << statusToString(status) << "\n";
+				allSolved = false;
+			}
+			solvedIndex++;
+		}
+	}
+
+	std::chrono::microseconds elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	std::cerr << amount << " sudokus in " << elapsed.count() << " us\n";
+	return allSolved ? 0 : 2;
+}
 
 int main(int argc, char* argv[]){
-	Sudoku* sudoku = new Sudoku(argv[1]);
-	sudoku->solve();
-	sudoku->print();
+	//Optional limits for the solver
+	SolveLimits limits;
+	//Time for each sudoku. 0 means no limit
+	std::chrono::milliseconds timeout(0);
+	bool batch = false;
+	std::string fileName;
+	for (int i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		if (argument.compare(0, 10, "--timeout=") == 0) {
+			timeout = std::chrono::milliseconds(std::atol(argument.c_str() + 10));
+		}
+		else if (argument.compare(0, 8, "--nodes=") == 0) {
+			limits.maxNodes = std::atol(argument.c_str() + 8);
+		}
+		else if (argument.compare("--unique") == 0) {
+			limits.checkUniqueness = true;
+		}
+		else if (argument.compare("--batch") == 0) {
+			batch = true;
+		}
+		else {
+			fileName = argument;
+		}
+	}
+
+	if (fileName.empty()) {
+		std::cerr << "Usage: " << argv[0] << " [--batch] FILE [--timeout=MILLISECONDS] [--nodes=MAXNODES] [--unique]\n";
+		return 1;
+	}
+
+	if (batch) {
+		return solveBatch(fileName, limits, timeout);
+	}
+
+	if (timeout.count() > 0) {
+		limits.deadline = std::chrono::steady_clock::now() + timeout;
+	}
+
+	try {
+		Sudoku* sudoku = new Sudoku(fileName);
+		sudoku->print();
+		SolveResult result = sudoku->solve(limits);
+		sudoku->print();
+		std::cout << statusToString(result.status) << " (" << result.nodes << " nodes, " << result.elapsed.count() << " us)\n";
+
+		delete(sudoku);
+		return result.status == SolveStatus::Solved ? 0 : 2;
+	}
+	catch (std::exception& error) {
+		std::cerr << error.what() << "\n";
+		return 1;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,593 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/BatchSolver.h"
+#include "../src/BitboardSolver.h"
+#include "../src/Cell.h"
+#include "../src/Layout.h"
+#include "../src/Sudoku.h"
+
+//Differential test of the solvers. Generates (or reads) sudokus, solves them with every engine
+//and checks the results against a plain backtracking solver used as reference.
+//Usage: Differential [--count=N] [--seed=N] [--size=N] [--nodes=N] [--file=FILE] [--engines=sudoku,bitboard,batch] [--variants]
+//The file has one sudoku per line, in the .sdkstring format. With --variants the generated sudokus get random
+//jigsaw regions, diagonals, killer cages and the non-consecutive rule. They are 4x4 and only Sudoku::solve is tested
+
+//Sudokus are vectors of numbers, 0 meaning vacant, in the order positionX + sideLength * positionY
+struct Puzzle {
+	int size;
+	std::vector<int> values;
+	//Constraints of the sudoku, as the generator made them. The reference solver checks them directly,
+	//so a wrong table in Layout can't make it agree with the engines
+	std::vector<int> regionOfCell;
+	//Cells of each region, worked out from regionOfCell
+	std::vector<std::vector<int>> cellsOfRegion;
+	bool diagonals;
+	bool nonConsecutive;
+	std::vector<Cage> cages;
+	//The same constraints for Sudoku::solve
+	std::shared_ptr<Layout> layout;
+	//Constraints in the .sudoku format, to print the sudokus that fail
+	std::string constraints;
+};
+
+//Sets the regions of the reference solver
+void setPuzzleRegions(Puzzle& puzzle, std::vector<int> regionOfCell) {
+	puzzle.regionOfCell = regionOfCell;
+	puzzle.cellsOfRegion.assign(puzzle.size * puzzle.size, std::vector<int>());
+	for (int cell = 0; cell < regionOfCell.size(); cell++) {
+		puzzle.cellsOfRegion.at(regionOfCell.at(cell)).push_back(cell);
+	}
+}
+
+//Gives the constraints of a standard sudoku, with the rectangular sub-squares as regions
+void setStandardConstraints(Puzzle& puzzle) {
+	int sideLength = puzzle.size * puzzle.size;
+	std::vector<int> regionOfCell;
+	for (int cell = 0; cell < sideLength * sideLength; cell++) {
+		int positionX = cell % sideLength;
+		int positionY = cell / sideLength;
+		regionOfCell.push_back(positionX / puzzle.size + puzzle.size * (positionY / puzzle.size));
+	}
+	setPuzzleRegions(puzzle, regionOfCell);
+	puzzle.diagonals = false;
+	puzzle.nonConsecutive = false;
+	puzzle.cages.clear();
+	puzzle.layout = std::make_shared<Layout>(puzzle.size);
+	puzzle.constraints.clear();
+}
+
+//Gives the mask of numbers the cell could have, looking at the rest of the cells. The cell itself is ignored
+int possibleMask(Puzzle& puzzle, int cell) {
+	int sideLength = puzzle.size * puzzle.size;
+	int mask = ((1 << sideLength) - 1) << 1;
+	int positionX = cell % sideLength;
+	int positionY = cell / sideLength;
+	//We make the cell vacant while we look at the rest
+	int ownValue = puzzle.values.at(cell);
+	puzzle.values.at(cell) = 0;
+
+	//Rows, columns and diagonals are worked out from the position, and regions from the regions the generator made
+	for (int i = 0; i < sideLength; i++) {
+		mask &= ~(1 << puzzle.values.at(i + sideLength * positionY));
+		mask &= ~(1 << puzzle.values.at(positionX + sideLength * i));
+		if (puzzle.diagonals && positionX == positionY) {
+			mask &= ~(1 << puzzle.values.at(i + sideLength * i));
+		}
+		if (puzzle.diagonals && positionX + positionY == sideLength - 1) {
+			mask &= ~(1 << puzzle.values.at((sideLength - 1 - i) + sideLength * i));
+		}
+	}
+	for (int other : puzzle.cellsOfRegion.at(puzzle.regionOfCell.at(cell))) {
+		mask &= ~(1 << puzzle.values.at(other));
+	}
+
+	//Orthogonally adjacent cells can't have consecutive numbers
+	if (puzzle.nonConsecutive) {
+		for (int other = 0; other < puzzle.values.size(); other++) {
+			int value = puzzle.values.at(other);
+			if (value != 0 && std::abs(other % sideLength - positionX) + std::abs(other / sideLength - positionY) == 1) {
+				mask &= ~(1 << (value - 1)) & ~(1 << (value + 1));
+			}
+		}
+	}
+
+	//The numbers of a cage can't repeat. Each of them is at least 1, so the vacant cells limit how big this one can be.
+	//The last one has to complete the sum
+	for (Cage& cage : puzzle.cages) {
+		if (std::find(cage.cells.begin(), cage.cells.end(), cell) == cage.cells.end()) {
+			continue;
+		}
+		int sum = 0;
+		int vacantOthers = 0;
+		for (int other : cage.cells) {
+			if (other != cell) {
+				mask &= ~(1 << puzzle.values.at(other));
+				sum += puzzle.values.at(other);
+				vacantOthers += puzzle.values.at(other) == 0;
+			}
+		}
+		for (int value = 1; value <= sideLength; value++) {
+			if (vacantOthers == 0 ? sum + value != cage.sum : sum + value + vacantOthers > cage.sum) {
+				mask &= ~(1 << value);
+			}
+		}
+	}
+	puzzle.values.at(cell) = ownValue;
+	//Bit 0 is cleared by the vacant cells, we don't need it
+	return mask & (((1 << sideLength) - 1) << 1);
+}
+
+//Reference solver. Counts the solutions up to limit, saving the first one. If random is given, tries the numbers in random order
+int countSolutions(Puzzle& puzzle, int limit, Puzzle& firstSolution, std::mt19937* random) {
+	int sideLength = puzzle.size * puzzle.size;
+
+	//We look for the vacant cell with the fewest possible numbers
+	int bestCell = -1;
+	int bestAmount = sideLength + 1;
+	int bestMask = 0;
+	for (int cell = 0; cell < puzzle.values.size(); cell++) {
+		if (puzzle.values.at(cell) == 0) {
+			int mask = possibleMask(puzzle, cell);
+			int amount = __builtin_popcount(mask);
+			if (amount < bestAmount) {
+				bestCell = cell;
+				bestAmount = amount;
+				bestMask = mask;
+			}
+		}
+	}
+
+	//If there isn't any vacant cell, it's solved
+	if (bestCell == -1) {
+		if (firstSolution.values.empty()) {
+			firstSolution = puzzle;
+		}
+		return 1;
+	}
+
+	std::vector<int> possibleValues;
+	for (int value = 1; value <= sideLength; value++) {
+		if (bestMask & (1 << value)) {
+			possibleValues.push_back(value);
+		}
+	}
+	if (random != nullptr) {
+		std::shuffle(possibleValues.begin(), possibleValues.end(), *random);
+	}
+
+	int found = 0;
+	for (int value : possibleValues) {
+		puzzle.values.at(bestCell) = value;
+		found += countSolutions(puzzle, limit - found, firstSolution, random);
+		if (found >= limit) {
+			break;
+		}
+	}
+	puzzle.values.at(bestCell) = 0;
+	return found;
+}
+
+//Checks that the given numbers don't break any constraint
+bool consistentPuzzle(Puzzle& puzzle) {
+	for (int cell = 0; cell < puzzle.values.size(); cell++) {
+		int value = puzzle.values.at(cell);
+		if (value != 0 && (possibleMask(puzzle, cell) & (1 << value)) == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//Checks that the solution is complete, follows every constraint and keeps the given numbers
+bool validSolution(Puzzle& puzzle, Puzzle& solution) {
+	if (solution.values.size() != puzzle.values.size()) {
+		return false;
+	}
+	Puzzle filled = puzzle;
+	filled.values = solution.values;
+	for (int cell = 0; cell < filled.values.size(); cell++) {
+		int value = filled.values.at(cell);
+		if (value == 0 || (puzzle.values.at(cell) != 0 && puzzle.values.at(cell) != value)) {
+			return false;
+		}
+	}
+	return consistentPuzzle(filled);
+}
+
+//Gives random constraints to an empty sudoku. The cages are added later, once the grid is filled
+void generateVariant(Puzzle& puzzle, std::mt19937& random) {
+	int sideLength = puzzle.size * puzzle.size;
+
+	//Jigsaw regions, made by swapping cells between the sub-squares
+	if (random() % 2 == 0) {
+		std::vector<int> regionOfCell = puzzle.regionOfCell;
+		int swaps = 1 + random() % sideLength;
+		for (int i = 0; i < swaps; i++) {
+			std::swap(regionOfCell.at(random() % regionOfCell.size()), regionOfCell.at(random() % regionOfCell.size()));
+		}
+		puzzle.layout->setRegions(regionOfCell);
+		setPuzzleRegions(puzzle, regionOfCell);
+
+		puzzle.constraints += "regions\n";
+		for (int positionY = 0; positionY < sideLength; positionY++) {
+			for (int positionX = 0; positionX < sideLength; positionX++) {
+				puzzle.constraints += std::to_string(regionOfCell.at(positionX + sideLength * positionY)) + (positionX == sideLength - 1 ? "\n" : "|");
+			}
+		}
+	}
+	if (random() % 3 == 0) {
+		puzzle.layout->addDiagonals();
+		puzzle.diagonals = true;
+		puzzle.constraints += "diagonals\n";
+	}
+	if (random() % 4 == 0) {
+		puzzle.layout->setNonConsecutive();
+		puzzle.nonConsecutive = true;
+		puzzle.constraints += "nonconsecutive\n";
+	}
+	puzzle.layout->compile();
+}
+
+//Splits a filled grid into random killer cages of 1 to 4 cells, with the sum of the numbers they have.
+//The cells of a cage are connected, and a number never repeats inside one
+void generateCages(Puzzle& puzzle, std::mt19937& random) {
+	int sideLength = puzzle.size * puzzle.size;
+	std::vector<bool> caged(puzzle.values.size(), false);
+	for (int cell = 0; cell < puzzle.values.size(); cell++) {
+		//Some cells are left without a cage
+		if (caged.at(cell) || random() % 3 == 0) {
+			continue;
+		}
+		std::vector<int> cageCells = { cell };
+		int usedValues = 1 << puzzle.values.at(cell);
+		int targetSize = 1 + random() % 4;
+		int current = cell;
+		caged.at(cell) = true;
+		while (cageCells.size() < targetSize) {
+			//We grow the cage to the right or down
+			int next = random() % 2 == 0 && current % sideLength < sideLength - 1 ? current + 1 : current + sideLength;
+			if (next >= puzzle.values.size() || caged.at(next) || (usedValues & (1 << puzzle.values.at(next)))) {
+				break;
+			}
+			cageCells.push_back(next);
+			usedValues |= 1 << puzzle.values.at(next);
+			caged.at(next) = true;
+			current = next;
+		}
+
+		int sum = 0;
+		puzzle.constraints += "cage|";
+		std::string positions;
+		for (int cageCell : cageCells) {
+			sum += puzzle.values.at(cageCell);
+			positions += "|" + std::to_string(cageCell % sideLength) + "," + std::to_string(cageCell / sideLength);
+		}
+		puzzle.layout->addCage(sum, cageCells);
+		Cage cage;
+		cage.sum = sum;
+		cage.cells = cageCells;
+		puzzle.cages.push_back(cage);
+		puzzle.constraints += std::to_string(sum) + positions + "\n";
+	}
+	puzzle.layout->compile();
+}
+
+//Generates a random sudoku. It can have one, several or no solutions
+Puzzle generatePuzzle(int size, bool variants, std::mt19937& random) {
+	int sideLength = size * size;
+
+	//We fill a grid in random order. Some random constraints have no solution, so we try again with new ones
+	Puzzle puzzle;
+	bool cages = false;
+	while (puzzle.values.empty()) {
+		Puzzle empty;
+		empty.size = size;
+		empty.values.assign(sideLength * sideLength, 0);
+		setStandardConstraints(empty);
+		if (variants) {
+			generateVariant(empty, random);
+			cages = random() % 3 == 0;
+		}
+		countSolutions(empty, 1, puzzle, &random);
+	}
+	if (cages) {
+		generateCages(puzzle, random);
+	}
+
+	//We make some cells vacant. Most of the times we only do it while there's only one solution
+	std::vector<int> order;
+	for (int cell = 0; cell < puzzle.values.size(); cell++) {
+		order.push_back(cell);
+	}
+	std::shuffle(order.begin(), order.end(), random);
+	int targetVacantCells = puzzle.values.size() / 2 + random() % (puzzle.values.size() / 3);
+	bool keepUnique = random() % 10 != 0;
+	int vacantCells = 0;
+	for (int i = 0; i < order.size() && vacantCells < targetVacantCells; i++) {
+		int value = puzzle.values.at(order.at(i));
+		puzzle.values.at(order.at(i)) = 0;
+
+		Puzzle solution;
+		if (keepUnique && countSolutions(puzzle, 2, solution, nullptr) != 1) {
+			puzzle.values.at(order.at(i)) = value;
+		}
+		else {
+			vacantCells++;
+		}
+	}
+
+	//Sometimes we put a wrong number, so it usually won't have a solution
+	if (random() % 20 == 0) {
+		puzzle.values.at(order.at(0)) = 1 + random() % sideLength;
+	}
+	return puzzle;
+}
+
+//Reads a sudoku in the .sdkstring format
+bool parsePuzzle(std::string line, Puzzle& puzzle) {
+	puzzle.size = 3;
+	setStandardConstraints(puzzle);
+	puzzle.values.clear();
+	for (char aux : line) {
+		if (aux == '.' || aux == '0') {
+			puzzle.values.push_back(0);
+		}
+		else if (aux >= '1' && aux <= '9') {
+			puzzle.values.push_back(aux - '0');
+		}
+	}
+	return puzzle.values.size() == 81;
+}
+
+std::string puzzleToString(Puzzle& puzzle) {
+	std::string output;
+	for (int value : puzzle.values) {
+		output += value == 0 ? "." : std::to_string(value);
+	}
+	return output;
+}
+
+//Solves the sudoku with the rule-based solver, returning the final grid
+SolveStatus solveWithSudoku(Puzzle& puzzle, SolveLimits limits, Puzzle& solution) {
+	int sideLength = puzzle.size * puzzle.size;
+	std::vector<Cell*> cells;
+	for (int cell = 0; cell < puzzle.values.size(); cell++) {
+		int value = puzzle.values.at(cell) == 0 ? -1 : puzzle.values.at(cell);
+		cells.push_back(new Cell(value, cell % sideLength, cell / sideLength, sideLength));
+	}
+
+	Sudoku sudoku(cells, puzzle.size, puzzle.layout);
+	for (Cell* cell : cells) {
+		delete(cell);
+	}
+	SolveResult result = sudoku.solve(limits);
+
+	solution.size = puzzle.size;
+	solution.values.clear();
+	for (int cell = 0; cell < puzzle.values.size(); cell++) {
+		int value = sudoku.getCellAt(cell % sideLength, cell / sideLength)->getValue();
+		solution.values.push_back(value == -1 ? 0 : value);
+	}
+	return result.status;
+}
+
+//Converts a 9x9 sudoku to the masks used by BitboardSolver and BatchSolver
+std::vector<uint16_t> puzzleToMasks(Puzzle& puzzle) {
+	std::vector<uint16_t> cells;
+	for (int value : puzzle.values) {
+		cells.push_back(value == 0 ? BitboardSolver::allNumbers : 1 << (value - 1));
+	}
+	return cells;
+}
+
+Puzzle masksToPuzzle(const uint16_t* cells) {
+	Puzzle puzzle;
+	puzzle.size = 3;
+	for (int cell = 0; cell < 81; cell++) {
+		//Only the cells with a single number are solved
+		bool single = cells[cell] != 0 && (cells[cell] & (cells[cell] - 1)) == 0;
+		puzzle.values.push_back(single ? __builtin_ctz(cells[cell]) + 1 : 0);
+	}
+	return puzzle;
+}
+
+//Results of one engine
+struct EngineStats {
+	std::string name;
+	long solved;
+	long unsolvable;
+	long multipleSolutions;
+	long budgetExceeded;
+	long failures;
+	std::chrono::microseconds elapsed;
+};
+
+//Checks the result of an engine against the amount of solutions found by the reference solver
+bool checkResult(EngineStats& stats, Puzzle& puzzle, int referenceSolutions, Puzzle& referenceSolution, SolveStatus status, Puzzle& solution) {
+	bool correct;
+	switch (status) {
+	case SolveStatus::Solved:
+		stats.solved++;
+		correct = referenceSolutions == 1 && solution.values == referenceSolution.values;
+		break;
+	case SolveStatus::Unsolvable:
+		stats.unsolvable++;
+		correct = referenceSolutions == 0;
+		break;
+	case SolveStatus::MultipleSolutions:
+		stats.multipleSolutions++;
+		correct = referenceSolutions > 1 && validSolution(puzzle, solution);
+		break;
+	default:
+		//Running out of budget isn't wrong, but we count it
+		stats.budgetExceeded++;
+		correct = true;
+		break;
+	}
+
+	if (!correct) {
+		stats.failures++;
+		std::cout << stats.name << " failed on " << puzzleToString(puzzle) << "\n" << puzzle.constraints;
+		std::cout << "  expected " << referenceSolutions << " solutions, got " << puzzleToString(solution) << "\n";
+	}
+	return correct;
+}
+
+int main(int argc, char* argv[]) {
+	long count = 1000;
+	unsigned int seed = 1;
+	int size = 3;
+	std::string fileName;
+	std::string engines = "sudoku,bitboard,batch";
+	bool variants = false;
+	SolveLimits limits;
+	limits.maxNodes = 100000;
+	limits.checkUniqueness = true;
+
+	for (int i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		if (argument.compare(0, 8, "--count=") == 0) {
+			count = std::atol(argument.c_str() + 8);
+		}
+		else if (argument.compare(0, 7, "--seed=") == 0) {
+			seed = std::atol(argument.c_str() + 7);
+		}
+		else if (argument.compare(0, 7, "--size=") == 0) {
+			size = std::atoi(argument.c_str() + 7);
+		}
+		else if (argument.compare(0, 8, "--nodes=") == 0) {
+			limits.maxNodes = std::atol(argument.c_str() + 8);
+		}
+		else if (argument.compare(0, 7, "--file=") == 0) {
+			fileName = argument.substr(7);
+		}
+		else if (argument.compare(0, 10, "--engines=") == 0) {
+			engines = argument.substr(10);
+		}
+		else if (argument.compare("--variants") == 0) {
+			variants = true;
+		}
+		else {
+			std::cerr << "Unknown argument " << argument << "\n";
+			return 1;
+		}
+	}
+	//The reference solver is too slow to generate bigger sudokus
+	if (size < 2 || size > 3) {
+		std::cerr << "Size must be 2 or 3\n";
+		return 1;
+	}
+	//Random 9x9 regions often have no solution, and the reference solver takes too long to find it out
+	if (variants && size != 2) {
+		std::cerr << "Variants are only generated with size 2\n";
+		return 1;
+	}
+
+	std::mt19937 random(seed);
+	std::ifstream file;
+	if (!fileName.empty()) {
+		file.open(fileName);
+		if (!file.is_open()) {
+			std::cerr << "Can't open " << fileName << "\n";
+			return 1;
+		}
+	}
+
+	//The 9x9 engines are only used on standard 9x9 sudokus
+	bool useSudoku = engines.find("sudoku") != std::string::npos;
+	bool useBitboard = size == 3 && !variants && engines.find("bitboard") != std::string::npos;
+	bool useBatch = size == 3 && !variants && engines.find("batch") != std::string::npos;
+	EngineStats sudokuStats = { "Sudoku::solve", 0, 0, 0, 0, 0, std::chrono::microseconds(0) };
+	EngineStats bitboardStats = { "BitboardSolver", 0, 0, 0, 0, 0, std::chrono::microseconds(0) };
+	EngineStats batchStats = { "BatchSolver", 0, 0, 0, 0, 0, std::chrono::microseconds(0) };
+	BitboardSolver bitboardSolver;
+	BatchSolver batchSolver(limits, std::chrono::milliseconds(0));
+
+	long tested = 0;
+	while (fileName.empty() ? tested < count : !file.eof()) {
+		//We work in blocks so the batch solver gets several sudokus at once
+		std::vector<Puzzle> puzzles;
+		while (puzzles.size() < 256 && (fileName.empty() ? tested < count : !file.eof())) {
+			Puzzle puzzle;
+			if (fileName.empty()) {
+				puzzle = generatePuzzle(size, variants, random);
+			}
+			else {
+				std::string line;
+				std::getline(file, line);
+				if (!parsePuzzle(line, puzzle)) {
+					continue;
+				}
+			}
+			puzzles.push_back(puzzle);
+			tested++;
+		}
+
+		//We get the reference results
+		std::vector<Puzzle> referenceSolutions(puzzles.size());
+		std::vector<int> referenceAmounts(puzzles.size(), 0);
+		for (int i = 0; i < puzzles.size(); i++) {
+			if (consistentPuzzle(puzzles.at(i))) {
+				referenceAmounts.at(i) = countSolutions(puzzles.at(i), 2, referenceSolutions.at(i), nullptr);
+			}
+		}
+
+		if (useSudoku) {
+			for (int i = 0; i < puzzles.size(); i++) {
+				Puzzle solution;
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				SolveStatus status = solveWithSudoku(puzzles.at(i), limits, solution);
+				sudokuStats.elapsed += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+				checkResult(sudokuStats, puzzles.at(i), referenceAmounts.at(i), referenceSolutions.at(i), status, solution);
+			}
+		}
+
+		if (useBitboard) {
+			for (int i = 0; i < puzzles.size(); i++) {
+				std::vector<uint16_t> cells = puzzleToMasks(puzzles.at(i));
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				SolveStatus status = bitboardSolver.solve(cells.data(), limits).status;
+				bitboardStats.elapsed += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+				Puzzle solution = masksToPuzzle(cells.data());
+				checkResult(bitboardStats, puzzles.at(i), referenceAmounts.at(i), referenceSolutions.at(i), status, solution);
+			}
+		}
+
+		if (useBatch) {
+			std::vector<uint16_t> sudokus;
+			for (Puzzle& puzzle : puzzles) {
+				std::vector<uint16_t> cells = puzzleToMasks(puzzle);
+				sudokus.insert(sudokus.end(), cells.begin(), cells.end());
+			}
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			std::vector<SolveStatus> statuses = batchSolver.solve(sudokus);
+			batchStats.elapsed += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+			for (int i = 0; i < puzzles.size(); i++) {
+				Puzzle solution = masksToPuzzle(sudokus.data() + i * 81);
+				checkResult(batchStats, puzzles.at(i), referenceAmounts.at(i), referenceSolutions.at(i), statuses.at(i), solution);
+			}
+		}
+	}
+
+	std::cout << "Tested " << tested << " sudokus\n";
+	long failures = 0;
+	for (EngineStats* stats : { &sudokuStats, &bitboardStats, &batchStats }) {
+		if (stats->solved + stats->unsolvable + stats->multipleSolutions + stats->budgetExceeded > 0) {
+			std::cout << stats->name << ": " << stats->solved << " solved, " << stats->unsolvable << " unsolvable, "
+				<< stats->multipleSolutions << " multiple solutions, " << stats->budgetExceeded << " over budget, "
+				<< stats->failures << " failures, " << stats->elapsed.count() / 1000 << " ms\n";
+		}
+		failures += stats->failures;
+	}
+
+	return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+#include "../src/BatchSolver.h"
+#include "../src/Sudoku.h"
+
+//libFuzzer target for the three file loaders and the batch mode. The first byte chooses the file format
+//and the rest is written to a temporary file, which is loaded and solved with a small budget.
+//Sudokus bigger than 16x16 are only loaded, since solving them is too slow under the sanitizers.
+//Loading can fail with an exception, but it must never crash, leak or hit undefined behaviour.
+//Without libFuzzer (FUZZ_STANDALONE) it runs the files given as arguments, to reproduce crashes
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+	if (size == 0) {
+		return 0;
+	}
+
+	SolveLimits limits;
+	limits.maxNodes = 50;
+	limits.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+
+	//Batch mode, one sudoku per line
+	if (data[0] % 4 == 3) {
+		std::istringstream input(std::string(reinterpret_cast<const char*>(data + 1), size - 1));
+		std::vector<uint16_t> sudokus;
+		std::string line;
+		while (std::getline(input, line)) {
+			uint16_t cells[81];
+			if (BitboardSolver::parse(line, cells)) {
+				sudokus.insert(sudokus.end(), cells, cells + 81);
+			}
+		}
+		BatchSolver batchSolver(limits, std::chrono::milliseconds(10));
+		batchSolver.solve(sudokus);
+		return 0;
+	}
+
+	const char* extensions[] = { "sudoku", "sdk", "sdkstring" };
+	std::string fileName = "/tmp/FuzzLoaders." + std::to_string(getpid()) + "." + extensions[data[0] % 4];
+
+	std::ofstream file(fileName, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(data + 1), size - 1);
+	file.close();
+
+	try {
+		Sudoku sudoku(fileName);
+		if (sudoku.getSize() <= 4) {
+			sudoku.solve(limits);
+		}
+	}
+	catch (std::runtime_error&) {
+		//Broken files have to be rejected this way
+	}
+
+	std::remove(fileName.c_str());
+	return 0;
+}
+
+#ifdef FUZZ_STANDALONE
+int main(int argc, char* argv[]) {
+	for (int i = 1; i < argc; i++) {
+		std::ifstream input(argv[i], std::ios::binary);
+		std::string data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+		std::cout << argv[i] << "\n";
+		LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+	}
+	return 0;
+}
+#endif
\ No newline at end of file